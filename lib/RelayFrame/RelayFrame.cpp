@@ -0,0 +1,171 @@
+#include "RelayFrame.h"
+
+#include <string.h>
+
+#define RELAY_RECORD_MAX (1 + 2 + RF_COUNT * 5)  // id + mask + worst-case varints
+
+static size_t putVarint(uint8_t *out, int32_t value) {
+  uint32_t z = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);  // zigzag
+  size_t n = 0;
+  while (z >= 0x80) {
+    out[n++] = (uint8_t)(z | 0x80);
+    z >>= 7;
+  }
+  out[n++] = (uint8_t)z;
+  return n;
+}
+
+// Returns bytes consumed, or 0 if the varint runs past `len` or is too long
+static size_t getVarint(const uint8_t *in, size_t len, int32_t *value) {
+  uint32_t z = 0;
+  for (size_t n = 0; n < len && n < 5; n++) {
+    z |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+    if (!(in[n] & 0x80)) {
+      *value = (int32_t)((z >> 1) ^ (0U - (z & 1)));
+      return n + 1;
+    }
+  }
+  return 0;
+}
+
+void relayCodecReset(RelayCodecState &st) {
+  memset(&st, 0, sizeof(st));
+}
+
+size_t relayEncodeFrame(RelayCodecState &st, const RelayRecord *recs, int count, bool keyframe,
+                        uint32_t timeMs, uint8_t *out, int *encoded) {
+  size_t pos = RELAY_HEADER_LEN;
+  int written = 0;
+  int i = 0;
+
+  for (; i < count && written < 255; i++) {
+    const RelayRecord &rec = recs[i];
+    if (rec.vehicleID >= RELAY_MAX_VEHICLES) continue;
+    int32_t *last = st.last[rec.vehicleID];
+
+    uint8_t buf[RELAY_RECORD_MAX];
+    size_t n = 3;
+    uint16_t mask = 0;
+    for (int f = 0; f < RF_COUNT; f++) {
+      int32_t base = keyframe ? 0 : last[f];
+      if (!keyframe && rec.v[f] == base) continue;
+      mask |= (uint16_t)(1 << f);
+      // Wrap-around arithmetic in uint32_t: defined for any pair of int32 values
+      n += putVarint(&buf[n], (int32_t)((uint32_t)rec.v[f] - (uint32_t)base));
+    }
+    if (mask == 0) continue;  // nothing changed since the last frame: receiver keeps its values
+    buf[0] = rec.vehicleID;
+    buf[1] = (uint8_t)(mask & 0xFF);
+    buf[2] = (uint8_t)(mask >> 8);
+
+    if (pos + n > RELAY_FRAME_MAX) break;
+    memcpy(&out[pos], buf, n);
+    pos += n;
+    memcpy(last, rec.v, sizeof(rec.v));
+    written++;
+  }
+
+  out[0] = 'T';
+  out[1] = 'R';
+  out[2] = RELAY_FRAME_VERSION;
+  out[3] = keyframe ? RELAY_FLAG_KEYFRAME : 0;
+  out[4] = (uint8_t)(st.seq & 0xFF);
+  out[5] = (uint8_t)(st.seq >> 8);
+  out[6] = (uint8_t)(timeMs & 0xFF);
+  out[7] = (uint8_t)((timeMs >> 8) & 0xFF);
+  out[8] = (uint8_t)((timeMs >> 16) & 0xFF);
+  out[9] = (uint8_t)(timeMs >> 24);
+  out[10] = (uint8_t)written;
+  st.seq++;
+
+  if (encoded) *encoded = i;
+  return pos;
+}
+
+int relayDecodeFrame(RelayCodecState &st, const uint8_t *in, size_t len, RelayRecord *recs, int maxRecs,
+                     RelayFrameHeader *hdr) {
+  if (len < RELAY_HEADER_LEN || in[0] != 'T' || in[1] != 'R' || in[2] != RELAY_FRAME_VERSION) return -1;
+
+  RelayFrameHeader h;
+  h.flags = in[3];
+  h.seq = (uint16_t)(in[4] | (in[5] << 8));
+  h.timeMs = (uint32_t)in[6] | ((uint32_t)in[7] << 8) | ((uint32_t)in[8] << 16) | ((uint32_t)in[9] << 24);
+  h.count = in[10];
+  if (hdr) *hdr = h;
+
+  bool keyframe = (h.flags & RELAY_FLAG_KEYFRAME) != 0;
+  // A missed frame may have carried deltas (or keyframe records) for any vehicle
+  uint32_t synced = st.syncedMask;
+  if (st.seqValid && h.seq != st.seq) synced = 0;
+
+  // Decode into scratch copies so a malformed frame leaves the values untouched
+  int32_t next[RELAY_MAX_VEHICLES][RF_COUNT];
+  memcpy(next, st.last, sizeof(next));
+
+  int out = 0;
+  bool malformed = h.count > maxRecs;
+  size_t pos = RELAY_HEADER_LEN;
+  for (int i = 0; i < h.count && !malformed; i++) {
+    if (pos + 3 > len) {
+      malformed = true;
+      break;
+    }
+    uint8_t id = in[pos];
+    uint16_t mask = (uint16_t)(in[pos + 1] | (in[pos + 2] << 8));
+    pos += 3;
+    if (id >= RELAY_MAX_VEHICLES) {
+      malformed = true;
+      break;
+    }
+
+    RelayRecord rec;
+    rec.vehicleID = id;
+    for (int f = 0; f < RF_COUNT; f++) {
+      int32_t base = keyframe ? 0 : next[id][f];
+      if (!(mask & (1 << f))) {
+        rec.v[f] = base;
+        continue;
+      }
+      int32_t delta;
+      size_t n = getVarint(&in[pos], len - pos, &delta);
+      if (n == 0) {
+        malformed = true;
+        break;
+      }
+      pos += n;
+      rec.v[f] = (int32_t)((uint32_t)base + (uint32_t)delta);
+    }
+    if (malformed) break;
+
+    if (keyframe) {
+      synced |= (1UL << id);
+    } else if (!(synced & (1UL << id))) {
+      continue;  // base values are stale: wait for this vehicle's next keyframe record
+    }
+    memcpy(next[id], rec.v, sizeof(rec.v));
+    recs[out++] = rec;
+  }
+
+  st.seq = (uint16_t)(h.seq + 1);
+  st.seqValid = true;
+  if (malformed) {
+    st.syncedMask = 0;
+    return -1;
+  }
+  memcpy(st.last, next, sizeof(next));
+  st.syncedMask = synced;
+  return out;
+}
+
+bool relayFileWriteFrame(FILE *f, const uint8_t *frame, size_t len) {
+  uint8_t prefix[2] = {(uint8_t)(len & 0xFF), (uint8_t)(len >> 8)};
+  return fwrite(prefix, 1, 2, f) == 2 && fwrite(frame, 1, len, f) == len;
+}
+
+long relayFileReadFrame(FILE *f, uint8_t *frame, size_t maxLen) {
+  uint8_t prefix[2];
+  if (fread(prefix, 1, 2, f) != 2) return -1;
+  size_t len = (size_t)(prefix[0] | (prefix[1] << 8));
+  if (len > maxLen || fread(frame, 1, len, f) != len) return -1;
+  return (long)len;
+}
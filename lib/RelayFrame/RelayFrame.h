@@ -0,0 +1,83 @@
+#pragma once
+
+// Compact batched summary frames sent by a display unit in relay mode.
+//
+// A frame carries one rollup record per vehicle. Each field is sent as a zigzag
+// varint delta from the value last sent for that vehicle, and only fields that
+// changed are present (a bit mask says which). Every few intervals a keyframe is
+// sent with all fields as deltas from 0; it may span several frames. The receiver
+// tracks sync per vehicle: a vehicle becomes synced when its keyframe record is
+// applied, and every vehicle loses sync when a sequence gap shows a frame was
+// missed. The codec has no Arduino dependencies and builds on a host.
+//
+// Frame layout (little-endian):
+//   'T' 'R' version flags seq:u16 timeMs:u32 count:u8
+//   count x { vehicleID:u8 mask:u16 varint[popcount(mask)] }
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define RELAY_FRAME_MAX 250          // fits one ESP-NOW payload
+#define RELAY_FRAME_VERSION 1
+#define RELAY_FLAG_KEYFRAME 0x01
+#define RELAY_MAX_VEHICLES 8         // vehicle IDs 0..7
+#define RELAY_HEADER_LEN 11
+
+// Rollup fields, fixed-point integers
+enum RelayField {
+  RF_STATUS,        // last status: 0=stuck, 1=driving, 2=charging
+  RF_VBATT_AVG,     // mean vBatt over the interval, centivolts
+  RF_VBATT_MIN,     // min vBatt over the interval, centivolts
+  RF_TEMP_MAX,      // max temperature over the interval, deci-degrees C
+  RF_V5V_MIN,       // min 5V rail over the interval, centivolts
+  RF_PACKETS,       // packets received in the interval
+  RF_MAX_GAP,       // longest gap between packets in the interval, ms/100
+  RF_LAPS,          // total laps counted
+  RF_LAP_MEDIAN,    // rolling median lap, ms/100
+  RF_LAP_P90,       // rolling p90 lap, ms/100
+  RF_LAP_BEST,      // best lap in the window, ms/100
+  RF_CHARGE_WH,     // energy of the last completed charge session, Wh*100
+  RF_ALERTS,        // active alert rule mask
+  RF_COUNT
+};
+
+struct RelayRecord {
+  uint8_t vehicleID;
+  int32_t v[RF_COUNT];
+};
+
+struct RelayFrameHeader {
+  uint8_t flags;
+  uint16_t seq;
+  uint32_t timeMs;
+  uint8_t count;
+};
+
+// Last values sent (encoder) or received (decoder) for each vehicle
+struct RelayCodecState {
+  int32_t last[RELAY_MAX_VEHICLES][RF_COUNT];
+  uint16_t seq;          // encoder: next sequence number. decoder: next expected
+  bool seqValid;         // decoder only: a frame has been received, so `seq` is meaningful
+  uint32_t syncedMask;   // decoder only: bit per vehicle whose values are known to be current
+};
+
+void relayCodecReset(RelayCodecState &st);
+
+// Encode up to `count` records into `out`. In a delta frame, vehicles with no changed
+// field are skipped. Encoding stops at the first record that does not fit in
+// RELAY_FRAME_MAX; `*encoded` receives how many input records were consumed so the
+// rest can go in the next frame. Returns the frame length.
+size_t relayEncodeFrame(RelayCodecState &st, const RelayRecord *recs, int count, bool keyframe,
+                        uint32_t timeMs, uint8_t *out, int *encoded);
+
+// Decode a frame into `recs` (absolute values). Delta records for vehicles that are not
+// synced are skipped, since their base values are stale; those vehicles come back with
+// their next keyframe record. Returns the number of records written to `recs`, or -1 if
+// the frame is malformed (all vehicles then lose sync).
+int relayDecodeFrame(RelayCodecState &st, const uint8_t *in, size_t len, RelayRecord *recs, int maxRecs,
+                     RelayFrameHeader *hdr);
+
+// File transport stand-in: frames stored as u16 length + bytes, for host-side testing
+bool relayFileWriteFrame(FILE *f, const uint8_t *frame, size_t len);
+long relayFileReadFrame(FILE *f, uint8_t *frame, size_t maxLen);  // -1 at end of file
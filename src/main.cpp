@@ -4,6 +4,7 @@
 #include <WiFi.h>
 #include <esp_now.h>
 #include <math.h>
+#include <RelayFrame.h>
 
 #define LCD_MOSI 23
 #define LCD_SCK 18
@@ -12,6 +13,27 @@
 #define LCD_RST 4
 #define LCD_BLK 32
 
+// Relay mode: periodically forward batched, delta-encoded per-vehicle summaries to a
+// central logger. Override from build_flags, e.g. -DRELAY_MODE=1 -DRELAY_TRANSPORT=1
+#define RELAY_TRANSPORT_ESPNOW 0    // ESP-NOW to relayPeerMac (other displays ignore the frames)
+#define RELAY_TRANSPORT_SERIAL 1    // "RELAY <hex>" lines in the serial log
+#define RELAY_TRANSPORT_LOOPBACK 2  // decoded locally and logged, to check the codec on a bench
+#ifndef RELAY_MODE
+#define RELAY_MODE 0
+#endif
+#ifndef RELAY_TRANSPORT
+#define RELAY_TRANSPORT RELAY_TRANSPORT_ESPNOW
+#endif
+#ifndef RELAY_INTERVAL_MS
+#define RELAY_INTERVAL_MS 5000UL
+#endif
+#ifndef RELAY_BATCH_MAX
+#define RELAY_BATCH_MAX 4           // vehicle records per frame
+#endif
+#ifndef RELAY_KEYFRAME_EVERY
+#define RELAY_KEYFRAME_EVERY 12     // full (non-delta) summary every N intervals so the logger can resync
+#endif
+
 int desiredVehicleID = 2; //set this to the desired vehicle ID. 1: front track. 2: west track 4: South track
 
 const int textSize = 3;
@@ -64,10 +86,144 @@ unsigned long graphS1_time[S1_GRAPH_POINTS_MAX];
 float graphS1_val[S1_GRAPH_POINTS_MAX];
 int graphS1_count = 0;
 
+// Guards the per-vehicle analytics state below. The ESP-NOW callback writes it from the
+// Wi-Fi task and loop() reads it on the other core; noInterrupts() only masks the calling
+// core, so this needs a real spinlock. Keep the sections short: copy in or out, then
+// parse, log and draw outside.
+portMUX_TYPE telemetryMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Lap-time analytics, one slot per vehicle ID. A lap is the interval between two
+// consecutive lapFlag packets, timed with the sender's millis when it is usable.
+const int MAX_VEHICLES = 8;                        // vehicle IDs 0..7 are tracked
+const int LAP_WINDOW = 32;                         // rolling window for median / p90 / best
+const unsigned long LAP_MIN_MS = 3000UL;           // repeated lap flags closer than this are ignored
+const unsigned long LAP_MAX_MS = 30UL * 60000UL;   // longer gaps (charging, stuck) restart lap timing
+struct LapStats {
+  bool hasRef;                          // a previous lap flag has been seen
+  unsigned long refVehicleMillis;       // sender millis at the previous lap flag (0 = not sent)
+  unsigned long refLocalMillis;         // local millis at the previous lap flag
+  unsigned long window[LAP_WINDOW];     // lap durations in arrival order (ring, oldest at head)
+  unsigned long sorted[LAP_WINDOW];     // the same durations kept in ascending order
+  int head;
+  int count;
+  unsigned long lastLap;
+  unsigned long totalLaps;
+};
+LapStats lapStats[MAX_VEHICLES];
+
+// Charge-session energy accounting. A session runs while vehicleStatus is "2" (charging);
+// vCharge*iCharge is integrated per packet with the trapezoid rule, no raw samples are kept.
+const int CHARGE_SESSIONS_MAX = 16;                // completed sessions kept (all vehicles, oldest dropped)
+const unsigned long CHARGE_GAP_MAX_MS = 30000UL;   // longer packet gaps are interpolated but flagged in gapMs
+const unsigned long CHARGE_STALE_MS = 120000UL;    // a session with no packets for this long is closed from loop()
+struct ChargeSession {
+  uint8_t vehicleID;
+  unsigned long startMillis;  // local millis at the first charging packet
+  unsigned long durationMs;
+  unsigned long gapMs;        // time spent in packet gaps longer than CHARGE_GAP_MAX_MS (quality flag)
+  unsigned long samples;
+  float wh;
+  float ah;
+  float peakAmps;
+  float vBattStart;
+  float vBattEnd;
+};
+struct ChargeTracker {
+  bool active;
+  unsigned long lastVehicleMillis;  // sender millis of the previous sample (0 = not sent)
+  unsigned long lastLocalMillis;
+  float lastVolts;
+  float lastAmps;
+  ChargeSession session;            // session in progress
+};
+ChargeTracker chargeTrackers[MAX_VEHICLES];
+ChargeSession chargeSessions[CHARGE_SESSIONS_MAX];
+int chargeSessionHead = 0;   // index of the oldest completed session
+int chargeSessionCount = 0;
+
+// Alert rules evaluated on every packet, per vehicle. Each rule watches one signal and
+// trips on a threshold, a rate of change (units per minute, smoothed over time) or a deviation
+// from the signal's EWMA mean (in standard deviations). setLevel/clearLevel give hysteresis
+// and a rule only changes state after `debounce` consecutive packets agree.
+enum AlertSignal : uint8_t { SIG_VBATT, SIG_TEMPERATURE, SIG_V5V, SIG_STUCK_SECONDS, SIG_COUNT };
+enum AlertKind : uint8_t { ALERT_ABOVE, ALERT_BELOW, ALERT_RATE_ABOVE, ALERT_RATE_BELOW, ALERT_DEVIATION };
+struct AlertRule {
+  const char *name;  // banner and log text
+  uint8_t signal;
+  uint8_t kind;
+  float setLevel;
+  float clearLevel;
+  uint8_t debounce;
+};
+const AlertRule alertRules[] = {
+  {"LOW BATT",  SIG_VBATT,         ALERT_BELOW,      10.5f, 10.9f, 5},
+  {"BATT SAG",  SIG_VBATT,         ALERT_RATE_BELOW, -0.5f, -0.2f, 5},  // V/min
+  {"HOT",       SIG_TEMPERATURE,   ALERT_ABOVE,      60.0f, 55.0f, 5},
+  {"TEMP RISE", SIG_TEMPERATURE,   ALERT_RATE_ABOVE,  5.0f,  2.0f, 5},  // C/min
+  {"5V LOW",    SIG_V5V,           ALERT_BELOW,       4.7f,  4.85f, 5},
+  {"5V DEV",    SIG_V5V,           ALERT_DEVIATION,   4.0f,  2.5f, 2},  // sigma from EWMA mean
+  {"STUCK",     SIG_STUCK_SECONDS, ALERT_ABOVE,      30.0f,  1.0f, 1},  // seconds in "Stuck"
+};
+const int ALERT_RULE_COUNT = sizeof(alertRules) / sizeof(alertRules[0]);
+const float ALERT_EWMA_ALPHA = 0.05f;             // mean/variance smoothing per packet
+const float ALERT_LEVEL_TAU_MS = 30000.0f;        // time constant of the level the rate is taken from
+const float ALERT_RATE_TAU_MS = 30000.0f;         // time constant of the rate smoothing
+const int ALERT_WARMUP_SAMPLES = 20;              // deviation rules stay quiet until the EWMA settles
+const float ALERT_VAR_MIN = 1e-4f;                // variance floor so a flat signal doesn't trip on noise
+const unsigned long ALERT_GAP_MAX_MS = 30000UL;   // rate baseline restarts after a longer packet gap
+const unsigned long ALERT_RATE_SETTLE_MS = 60000UL;  // rate rules stay quiet this long after a status change
+const uint8_t ALERT_STATUS_UNKNOWN = 0xFF;
+struct AlertSignalState {
+  uint16_t samples;
+  float mean;
+  float var;
+  float level;  // time-smoothed value, so the rate does not depend on the packet rate
+  float rate;   // units per minute
+};
+struct AlertRuleState {
+  bool active;
+  uint8_t pending;  // consecutive packets disagreeing with `active`
+};
+struct AlertVehicleState {
+  bool hasSample;
+  unsigned long lastVehicleMillis;
+  unsigned long lastLocalMillis;
+  uint8_t status;                   // 0=stuck, 1=driving, 2=charging, ALERT_STATUS_UNKNOWN
+  unsigned long statusSinceMillis;
+  uint16_t activeMask;  // bit per rule in alertRules
+  AlertSignalState sig[SIG_COUNT];
+  AlertRuleState rule[ALERT_RULE_COUNT];
+};
+AlertVehicleState alertStates[MAX_VEHICLES];
+
+// Relay rollups, accumulated per packet and reset each time a summary is sent
+uint8_t relayPeerMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};  // central logger (broadcast by default)
+struct RelayRollup {
+  bool seen;                       // vehicle has been heard since boot
+  uint8_t status;
+  uint16_t packets;                // packets in the current interval
+  unsigned long lastPacketMillis;
+  unsigned long maxGapMs;          // longest gap between packets in the current interval
+  uint16_t vBattSamples;           // packets in the interval whose vBatt parsed
+  float vBattSum;
+  float vBattMin;                  // min/max are NAN until a field parses in the interval
+  float tempMax;
+  float v5vMin;
+};
+RelayRollup relayRollups[MAX_VEHICLES];
+static_assert(MAX_VEHICLES <= RELAY_MAX_VEHICLES, "relayEncoder.last is indexed by vehicle ID");
+RelayCodecState relayEncoder;
+RelayCodecState relayLoopbackDecoder;
+unsigned long lastRelaySend = 0;
+unsigned long relayIntervalCount = 0;
+
 Adafruit_ST7789 lcd = Adafruit_ST7789(LCD_CS, LCD_DC, LCD_RST);
 
 // Forward declarations
 void drawVBattGraph();
+void drawAlertBanner();
+void drawChargeStats();
+void drawLapStats();
 void updateDisplayFromData();
 
 // Shared data populated by receiveCallback, consumed in loop()
@@ -95,6 +251,365 @@ void formatMacAddress(const uint8_t *macAddr, char *buffer, int maxLength) {
              macAddr[3], macAddr[4], macAddr[5]);
   }
 
+// Index of the first sorted lap >= value (binary search over the sorted window)
+int lapLowerBound(const LapStats &ls, unsigned long value) {
+  int lo = 0;
+  int hi = ls.count;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (ls.sorted[mid] < value) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// Add a lap to the rolling window. The oldest lap is evicted when full and the
+// sorted copy is updated in place, so percentiles never need a full re-sort.
+void lapWindowPush(LapStats &ls, unsigned long lapMs) {
+  int slot;
+  if (ls.count >= LAP_WINDOW) {
+    unsigned long oldest = ls.window[ls.head];
+    int idx = lapLowerBound(ls, oldest);
+    memmove(&ls.sorted[idx], &ls.sorted[idx + 1], (ls.count - idx - 1) * sizeof(ls.sorted[0]));
+    slot = ls.head;
+    ls.head = (ls.head + 1) % LAP_WINDOW;
+    ls.count--;
+  } else {
+    slot = (ls.head + ls.count) % LAP_WINDOW;
+  }
+  ls.window[slot] = lapMs;
+
+  int idx = lapLowerBound(ls, lapMs);
+  memmove(&ls.sorted[idx + 1], &ls.sorted[idx], (ls.count - idx) * sizeof(ls.sorted[0]));
+  ls.sorted[idx] = lapMs;
+  ls.count++;
+}
+
+unsigned long lapMedian(const LapStats &ls) {
+  if (ls.count == 0) return 0;
+  int mid = ls.count / 2;
+  if (ls.count % 2 == 1) return ls.sorted[mid];
+  return (ls.sorted[mid - 1] + ls.sorted[mid]) / 2;
+}
+
+// Nearest-rank percentile (pct 0..100) over the rolling window
+unsigned long lapPercentile(const LapStats &ls, int pct) {
+  if (ls.count == 0) return 0;
+  int rank = (pct * ls.count + 99) / 100;  // ceil(pct/100 * count)
+  if (rank < 1) rank = 1;
+  if (rank > ls.count) rank = ls.count;
+  return ls.sorted[rank - 1];
+}
+
+// Format a lap duration as m:ss.s
+void formatLapTime(unsigned long ms, char *buffer, int maxLength) {
+  unsigned long tenths = (ms + 50) / 100;
+  snprintf(buffer, maxLength, "%lu:%02lu.%lu", tenths / 600, (tenths / 10) % 60, tenths % 10);
+}
+
+// Handle a lapFlag packet for a vehicle. Returns the completed lap duration in ms,
+// or 0 if this flag only (re)started lap timing or was a duplicate.
+unsigned long lapRecordFlag(uint8_t vehicleID, unsigned long vehicleMillis, unsigned long localMillis) {
+  if (vehicleID >= MAX_VEHICLES) return 0;
+  LapStats &ls = lapStats[vehicleID];
+
+  unsigned long lapMs = 0;
+  if (ls.hasRef) {
+    // Prefer sender time (immune to radio latency); fall back to local time if the
+    // sender did not report millis or its clock went backwards (vehicle reboot).
+    if (vehicleMillis != 0 && ls.refVehicleMillis != 0 && vehicleMillis >= ls.refVehicleMillis) {
+      lapMs = vehicleMillis - ls.refVehicleMillis;
+    } else {
+      lapMs = localMillis - ls.refLocalMillis;
+    }
+    if (lapMs < LAP_MIN_MS) return 0;  // same lap reported in several packets
+  }
+
+  ls.hasRef = true;
+  ls.refVehicleMillis = vehicleMillis;
+  ls.refLocalMillis = localMillis;
+
+  if (lapMs == 0 || lapMs > LAP_MAX_MS) return 0;
+
+  lapWindowPush(ls, lapMs);
+  ls.lastLap = lapMs;
+  ls.totalLaps++;
+  return lapMs;
+}
+
+// Format a duration coarsely for long spans: 45s, 12m05s, 1h30m
+void formatDuration(unsigned long ms, char *buffer, int maxLength) {
+  unsigned long s = ms / 1000;
+  if (s < 60) {
+    snprintf(buffer, maxLength, "%lus", s);
+  } else if (s < 3600) {
+    snprintf(buffer, maxLength, "%lum%02lus", s / 60, s % 60);
+  } else {
+    snprintf(buffer, maxLength, "%luh%02lum", s / 3600, (s / 60) % 60);
+  }
+}
+
+// Most recent completed charge session for a vehicle, or NULL if none is in the table
+const ChargeSession *chargeLastSession(uint8_t vehicleID) {
+  for (int n = chargeSessionCount - 1; n >= 0; n--) {
+    const ChargeSession &s = chargeSessions[(chargeSessionHead + n) % CHARGE_SESSIONS_MAX];
+    if (s.vehicleID == vehicleID) return &s;
+  }
+  return NULL;
+}
+
+// Integrate the interval from the tracker's previous sample to this one
+void chargeIntegrate(ChargeTracker &ct, unsigned long vehicleMillis, unsigned long localMillis,
+                     float volts, float amps) {
+  // Interval since the previous packet, on the sender clock when it is usable
+  unsigned long dt;
+  if (vehicleMillis != 0 && ct.lastVehicleMillis != 0 && vehicleMillis >= ct.lastVehicleMillis) {
+    dt = vehicleMillis - ct.lastVehicleMillis;
+  } else {
+    dt = localMillis - ct.lastLocalMillis;
+  }
+  ct.session.durationMs += dt;
+  if (dt > CHARGE_GAP_MAX_MS) ct.session.gapMs += dt;
+
+  // Trapezoid over the (possibly irregular) interval; lost packets in between
+  // are covered by linear interpolation between the two samples we did get.
+  float hours = (float)dt / 3600000.0f;
+  ct.session.ah += 0.5f * (ct.lastAmps + amps) * hours;
+  ct.session.wh += 0.5f * (ct.lastVolts * ct.lastAmps + volts * amps) * hours;
+}
+
+// End the tracker's session and append it to chargeSessions. Returns false if the
+// session covered no time (a single charging packet) and was dropped.
+bool chargeCloseSession(ChargeTracker &ct) {
+  ct.active = false;
+  if (ct.session.durationMs == 0) return false;
+  int slot;
+  if (chargeSessionCount >= CHARGE_SESSIONS_MAX) {
+    slot = chargeSessionHead;
+    chargeSessionHead = (chargeSessionHead + 1) % CHARGE_SESSIONS_MAX;
+  } else {
+    slot = (chargeSessionHead + chargeSessionCount) % CHARGE_SESSIONS_MAX;
+    chargeSessionCount++;
+  }
+  chargeSessions[slot] = ct.session;
+  return true;
+}
+
+// Print a completed session as one "Charge | ..." log line
+void chargeLogSession(const ChargeSession &cs, const char *reason) {
+  char durBuf[16];
+  formatDuration(cs.durationMs, durBuf, sizeof(durBuf));
+  // Ah needed per volt of battery rise: trending up means charging is getting less effective
+  float vRise = cs.vBattEnd - cs.vBattStart;
+  float ahPerVolt = (vRise > 0.05f) ? cs.ah / vRise : 0.0f;
+  Serial.printf("Charge | Vehicle: %u | Close: %s | Time: %s | Wh: %.2f | Ah: %.3f | PeakA: %.2f | vBatt: %.2f->%.2f | AhPerV: %.3f | Gap: %lus | Samples: %lu\n",
+                cs.vehicleID, reason, durBuf, cs.wh, cs.ah, cs.peakAmps, cs.vBattStart, cs.vBattEnd, ahPerVolt,
+                cs.gapMs / 1000, cs.samples);
+}
+
+// Close sessions whose vehicle stopped transmitting while charging. Called from loop();
+// nothing is integrated past the last packet since the charge current is unknown.
+void chargeCloseStale() {
+  for (int id = 0; id < MAX_VEHICLES; id++) {
+    portENTER_CRITICAL(&telemetryMux);
+    unsigned long now = millis();  // read inside the lock so a just-received packet is never "in the future"
+    ChargeTracker &ct = chargeTrackers[id];
+    bool closed = false;
+    ChargeSession cs;
+    if (ct.active && now - ct.lastLocalMillis > CHARGE_STALE_MS) {
+      closed = chargeCloseSession(ct);
+      cs = ct.session;
+    }
+    portEXIT_CRITICAL(&telemetryMux);
+    if (closed) chargeLogSession(cs, "timeout");
+  }
+}
+
+// Feed one packet into the charge integrator. Sessions open on the first charging
+// packet and close on the first packet with any other status; the interval up to
+// that packet still counts. Fields that did not parse are NAN: a charging packet
+// without volts/amps is skipped (the next one integrates across it), and a closing
+// one reuses the last good values. Returns true when a session was closed and
+// appended to chargeSessions.
+bool chargeRecordSample(uint8_t vehicleID, bool charging, unsigned long vehicleMillis, unsigned long localMillis,
+                        float volts, float amps, float vBatt) {
+  if (vehicleID >= MAX_VEHICLES) return false;
+  ChargeTracker &ct = chargeTrackers[vehicleID];
+
+  if (amps < 0.0f) amps = 0.0f;
+  bool usable = !isnan(volts) && !isnan(amps);
+
+  if (!charging) {
+    if (!ct.active) return false;
+    if (!usable) {
+      volts = ct.lastVolts;
+      amps = ct.lastAmps;
+    }
+    chargeIntegrate(ct, vehicleMillis, localMillis, volts, amps);
+    if (!isnan(vBatt)) ct.session.vBattEnd = vBatt;
+    return chargeCloseSession(ct);
+  }
+
+  if (!usable) return false;
+
+  if (!ct.active) {
+    ct.active = true;
+    memset(&ct.session, 0, sizeof(ct.session));
+    ct.session.vehicleID = vehicleID;
+    ct.session.startMillis = localMillis;
+    ct.session.vBattStart = vBatt;  // both stay NAN until a vBatt parses, see below
+    ct.session.vBattEnd = vBatt;
+  } else {
+    chargeIntegrate(ct, vehicleMillis, localMillis, volts, amps);
+  }
+
+  ct.lastVehicleMillis = vehicleMillis;
+  ct.lastLocalMillis = localMillis;
+  ct.lastVolts = volts;
+  ct.lastAmps = amps;
+  ct.session.samples++;
+  if (!isnan(vBatt)) {
+    if (isnan(ct.session.vBattStart)) ct.session.vBattStart = vBatt;
+    ct.session.vBattEnd = vBatt;
+  }
+  if (amps > ct.session.peakAmps) ct.session.peakAmps = amps;
+  return false;
+}
+
+// Parse a numeric telemetry field; NAN if it is empty or not entirely a number
+float parseFloatField(const char *text) {
+  char *end;
+  float v = strtof(text, &end);
+  if (end == text || *end != '\0') return NAN;
+  return v;
+}
+
+// Run every alert rule against one packet: a single pass over the signals and the rule
+// table, no buffers, so the cost per packet is constant. `values` holds the raw signals,
+// NAN for fields that did not parse (their rules are skipped). SIG_STUCK_SECONDS is
+// derived here from `status`. Returns a mask of rules whose state changed; `observed`
+// receives the value each rule compared against.
+uint16_t alertEvaluate(uint8_t vehicleID, unsigned long vehicleMillis, unsigned long localMillis,
+                       const float *values, uint8_t status, float *observed) {
+  if (vehicleID >= MAX_VEHICLES) return 0;
+  AlertVehicleState &as = alertStates[vehicleID];
+
+  unsigned long dt = 0;
+  if (as.hasSample) {
+    if (vehicleMillis != 0 && as.lastVehicleMillis != 0 && vehicleMillis >= as.lastVehicleMillis) {
+      dt = vehicleMillis - as.lastVehicleMillis;
+    } else {
+      dt = localMillis - as.lastLocalMillis;
+    }
+  }
+  bool rateUsable = as.hasSample && dt > 0 && dt <= ALERT_GAP_MAX_MS;
+  as.lastVehicleMillis = vehicleMillis;
+  as.lastLocalMillis = localMillis;
+
+  // A status change (e.g. leaving the charger) moves vBatt and temperature steeply
+  // on its own, so rate baselines restart and rate rules wait for things to settle
+  bool statusChanged = !as.hasSample || status != as.status;
+  if (statusChanged) {
+    as.status = status;
+    as.statusSinceMillis = localMillis;
+    rateUsable = false;
+  }
+  bool rateSettled = localMillis - as.statusSinceMillis >= ALERT_RATE_SETTLE_MS;
+  as.hasSample = true;
+
+  float x[SIG_COUNT];
+  for (int s = 0; s < SIG_COUNT - 1; s++) x[s] = values[s];
+  x[SIG_STUCK_SECONDS] = (status == 0) ? (float)(localMillis - as.statusSinceMillis) / 1000.0f : 0.0f;
+
+  // Update EWMA mean/variance and smoothed rate; z is taken against the state
+  // before this sample so a single outlier is judged against the past. The rate is the
+  // slope of a time-constant EWMA of the level, smoothed again over time: weights come
+  // from dt, so noise rejection is the same whether packets arrive every 250 ms or 1 s
+  float z[SIG_COUNT];
+  bool valid[SIG_COUNT];
+  for (int s = 0; s < SIG_COUNT; s++) {
+    AlertSignalState &ss = as.sig[s];
+    valid[s] = !isnan(x[s]);
+    z[s] = 0.0f;
+    if (!valid[s]) continue;
+
+    if (ss.samples == 0) {
+      ss.mean = x[s];
+      ss.var = 0.0f;
+      ss.level = x[s];
+      ss.rate = 0.0f;
+    } else {
+      float dev = x[s] - ss.mean;
+      if (ss.samples >= ALERT_WARMUP_SAMPLES) {
+        float var = (ss.var > ALERT_VAR_MIN) ? ss.var : ALERT_VAR_MIN;
+        z[s] = fabsf(dev) / sqrtf(var);
+      }
+      ss.mean += ALERT_EWMA_ALPHA * dev;
+      ss.var = (1.0f - ALERT_EWMA_ALPHA) * (ss.var + ALERT_EWMA_ALPHA * dev * dev);
+
+      if (rateUsable) {
+        float prevLevel = ss.level;
+        ss.level += (1.0f - expf(-(float)dt / ALERT_LEVEL_TAU_MS)) * (x[s] - ss.level);
+        float slope = (ss.level - prevLevel) * 60000.0f / (float)dt;
+        ss.rate += (1.0f - expf(-(float)dt / ALERT_RATE_TAU_MS)) * (slope - ss.rate);
+      } else {
+        ss.level = x[s];
+        ss.rate = 0.0f;
+      }
+    }
+    if (ss.samples < 0xFFFF) ss.samples++;
+  }
+
+  uint16_t changed = 0;
+  for (int r = 0; r < ALERT_RULE_COUNT; r++) {
+    const AlertRule &rule = alertRules[r];
+    AlertRuleState &rs = as.rule[r];
+    observed[r] = 0.0f;
+
+    // The trend behind an active rate alert no longer applies after a status change:
+    // clear it now rather than leaving it frozen on the banner until the rate settles
+    bool rateRule = rule.kind == ALERT_RATE_ABOVE || rule.kind == ALERT_RATE_BELOW;
+    if (rateRule && !rateSettled) {
+      if (rs.active) {
+        rs.active = false;
+        changed |= (1 << r);
+      }
+      rs.pending = 0;
+      continue;
+    }
+    if (!valid[rule.signal]) continue;
+
+    float val;
+    if (rateRule) val = as.sig[rule.signal].rate;
+    else if (rule.kind == ALERT_DEVIATION) val = z[rule.signal];
+    else val = x[rule.signal];
+    observed[r] = val;
+
+    bool trip, clear;
+    if (rule.kind == ALERT_BELOW || rule.kind == ALERT_RATE_BELOW) {
+      trip = val < rule.setLevel;
+      clear = val > rule.clearLevel;
+    } else {
+      trip = val > rule.setLevel;
+      clear = val < rule.clearLevel;
+    }
+
+    if (rs.active ? clear : trip) {
+      rs.pending++;
+      if (rs.pending >= rule.debounce) {
+        rs.active = !rs.active;
+        rs.pending = 0;
+        changed |= (1 << r);
+      }
+    } else {
+      rs.pending = 0;
+    }
+  }
+
+  as.activeMask ^= changed;
+  return changed;
+}
+
 void receiveCallback(const uint8_t *mac, const uint8_t *data, int len) {
     char buffer[ESP_NOW_MAX_DATA_LEN + 1];
     int msgLen = min(ESP_NOW_MAX_DATA_LEN, len);
@@ -124,7 +639,94 @@ void receiveCallback(const uint8_t *mac, const uint8_t *data, int len) {
       return;
     }
 
-    
+    // Lap analytics run for every vehicle, not only the one on screen
+    if (parsed >= 14 && lapFlagInt && vehicleID < MAX_VEHICLES) {
+      portENTER_CRITICAL(&telemetryMux);
+      unsigned long lapMs = lapRecordFlag(vehicleID, vehicleMillis, millis());
+      LapStats ls = lapStats[vehicleID];
+      portEXIT_CRITICAL(&telemetryMux);
+
+      if (lapMs > 0) {
+        char lapBuf[16], medBuf[16], p90Buf[16], bestBuf[16];
+        formatLapTime(lapMs, lapBuf, sizeof(lapBuf));
+        formatLapTime(lapMedian(ls), medBuf, sizeof(medBuf));
+        formatLapTime(lapPercentile(ls, 90), p90Buf, sizeof(p90Buf));
+        formatLapTime(ls.sorted[0], bestBuf, sizeof(bestBuf));
+        Serial.printf("Lap | Vehicle: %u | Lap: %s | Median: %s | P90: %s | Best: %s | N: %d | Total: %lu\n",
+                      vehicleID, lapBuf, medBuf, p90Buf, bestBuf, ls.count, ls.totalLaps);
+      }
+    }
+
+    // Charge energy accounting, also for every vehicle
+    if (vehicleID < MAX_VEHICLES) {
+      bool charging = strcmp(vehicleStatus, "2") == 0;
+      float vChargeVal = parseFloatField(vCharge);
+      float iChargeVal = parseFloatField(iCharge);
+      float vBattVal = parseFloatField(vBatt);
+      portENTER_CRITICAL(&telemetryMux);
+      bool closed = chargeRecordSample(vehicleID, charging, vehicleMillis, millis(),
+                                       vChargeVal, iChargeVal, vBattVal);
+      ChargeSession cs;
+      if (closed) cs = *chargeLastSession(vehicleID);
+      portEXIT_CRITICAL(&telemetryMux);
+
+      if (closed) chargeLogSession(cs, "end");
+    }
+
+    // Alert rules, also for every vehicle
+    if (vehicleID < MAX_VEHICLES) {
+      float values[SIG_COUNT];
+      values[SIG_VBATT] = parseFloatField(vBatt);
+      values[SIG_TEMPERATURE] = parseFloatField(temperature);
+      values[SIG_V5V] = parseFloatField(v5v);
+      float observed[ALERT_RULE_COUNT];
+      uint8_t status = ALERT_STATUS_UNKNOWN;
+      if (strcmp(vehicleStatus, "0") == 0) status = 0;
+      else if (strcmp(vehicleStatus, "1") == 0) status = 1;
+      else if (strcmp(vehicleStatus, "2") == 0) status = 2;
+      portENTER_CRITICAL(&telemetryMux);
+      uint16_t changed = alertEvaluate(vehicleID, vehicleMillis, millis(), values, status, observed);
+      uint16_t active = alertStates[vehicleID].activeMask;
+      portEXIT_CRITICAL(&telemetryMux);
+
+      for (int r = 0; r < ALERT_RULE_COUNT; r++) {
+        if (!(changed & (1 << r))) continue;
+        Serial.printf("Alert | Vehicle: %u | %s | %s | Value: %.3f\n",
+                      vehicleID, alertRules[r].name, (active & (1 << r)) ? "SET" : "CLEAR", observed[r]);
+      }
+    }
+
+    // Relay rollups, also for every vehicle
+    if (RELAY_MODE && vehicleID < MAX_VEHICLES) {
+      float vBattVal = parseFloatField(vBatt);
+      float tempVal = parseFloatField(temperature);
+      float v5vVal = parseFloatField(v5v);
+      uint8_t statusVal = (uint8_t)atoi(vehicleStatus);
+      unsigned long nowMs = millis();
+      portENTER_CRITICAL(&telemetryMux);
+      RelayRollup &ru = relayRollups[vehicleID];
+      if (ru.seen && nowMs - ru.lastPacketMillis > ru.maxGapMs) ru.maxGapMs = nowMs - ru.lastPacketMillis;
+      if (ru.packets == 0) {
+        ru.vBattMin = NAN;
+        ru.tempMax = NAN;
+        ru.v5vMin = NAN;
+      }
+      // A field that failed to parse is left out rather than counted as 0
+      if (!isnan(vBattVal)) {
+        if (isnan(ru.vBattMin) || vBattVal < ru.vBattMin) ru.vBattMin = vBattVal;
+        ru.vBattSum += vBattVal;
+        ru.vBattSamples++;
+      }
+      if (!isnan(tempVal) && (isnan(ru.tempMax) || tempVal > ru.tempMax)) ru.tempMax = tempVal;
+      if (!isnan(v5vVal) && (isnan(ru.v5vMin) || v5vVal < ru.v5vMin)) ru.v5vMin = v5vVal;
+      ru.status = statusVal;
+      ru.lastPacketMillis = nowMs;
+      ru.seen = true;
+      if (ru.packets < 0xFFFF) ru.packets++;
+      portEXIT_CRITICAL(&telemetryMux);
+    }
+
+
     // If vehicleID is the one we want, copy parsed fields into sharedData and signal main loop
     if (vehicleID == desiredVehicleID) {
       ///*
@@ -201,6 +803,103 @@ void receiveCallback(const uint8_t *mac, const uint8_t *data, int len) {
 void sentCallback(const uint8_t *macAddr, esp_now_send_status_t status) {
     char macStr[18];
     formatMacAddress(macAddr, macStr, 18);
+    // Only relay frames are sent; unicast failures mean the logger missed a frame
+    // (the next keyframe resyncs it). Broadcasts always report success.
+    if (status != ESP_NOW_SEND_SUCCESS) {
+      Serial.printf("Relay | Send failed | Peer: %s\n", macStr);
+    }
+}
+
+// Hand one encoded frame to the configured relay transport
+void relayTransmit(const uint8_t *frame, size_t len) {
+  if (RELAY_TRANSPORT == RELAY_TRANSPORT_ESPNOW) {
+    esp_now_send(relayPeerMac, frame, len);
+  } else if (RELAY_TRANSPORT == RELAY_TRANSPORT_SERIAL) {
+    Serial.print("RELAY ");
+    for (size_t i = 0; i < len; i++) Serial.printf("%02x", frame[i]);
+    Serial.println();
+  } else {
+    RelayRecord recs[RELAY_BATCH_MAX];
+    RelayFrameHeader hdr;
+    int n = relayDecodeFrame(relayLoopbackDecoder, frame, len, recs, RELAY_BATCH_MAX, &hdr);
+    Serial.printf("Relay | Seq: %u | %s | Bytes: %u | Records: %d\n",
+                  hdr.seq, (hdr.flags & RELAY_FLAG_KEYFRAME) ? "key" : "delta", (unsigned)len, n);
+    for (int i = 0; i < n; i++) {
+      const int32_t *v = recs[i].v;
+      Serial.printf("Relay | Vehicle: %u | Status: %ld | vBatt: %ld/%ld | TempMax: %ld | v5vMin: %ld | Pkts: %ld | Gap: %ld | Laps: %ld | Med: %ld | P90: %ld | Best: %ld | Wh: %ld | Alerts: %lx\n",
+                    recs[i].vehicleID, (long)v[RF_STATUS], (long)v[RF_VBATT_AVG], (long)v[RF_VBATT_MIN],
+                    (long)v[RF_TEMP_MAX], (long)v[RF_V5V_MIN], (long)v[RF_PACKETS], (long)v[RF_MAX_GAP],
+                    (long)v[RF_LAPS], (long)v[RF_LAP_MEDIAN], (long)v[RF_LAP_P90], (long)v[RF_LAP_BEST],
+                    (long)v[RF_CHARGE_WH], (unsigned long)v[RF_ALERTS]);
+    }
+  }
+}
+
+// Scale a rollup value to the relay's fixed point, or keep `prev` if it is NAN
+int32_t relayFixed(float value, float scale, int32_t prev) {
+  return isnan(value) ? prev : (int32_t)lroundf(value * scale);
+}
+
+// Build one summary record per vehicle heard so far, reset the interval rollups and
+// send them in frames of up to RELAY_BATCH_MAX records.
+void relaySendSummaries() {
+  RelayRecord recs[MAX_VEHICLES];
+  int n = 0;
+
+  portENTER_CRITICAL(&telemetryMux);
+  // Read the clock inside the lock: a packet handled after an earlier millis() would
+  // leave lastPacketMillis ahead of it and the gap below would wrap around
+  unsigned long now = millis();
+  for (int id = 0; id < MAX_VEHICLES; id++) {
+    RelayRollup &ru = relayRollups[id];
+    if (!ru.seen) continue;
+    RelayRecord &rec = recs[n++];
+    rec.vehicleID = id;
+    const int32_t *prev = relayEncoder.last[id];
+
+    rec.v[RF_STATUS] = ru.status;
+    // A field with no valid reading this interval (nothing heard, or nothing parsed)
+    // repeats its last value, so it costs no bytes
+    bool heard = ru.packets > 0;
+    float vBattAvg = ru.vBattSamples > 0 ? ru.vBattSum / ru.vBattSamples : NAN;
+    rec.v[RF_VBATT_AVG] = relayFixed(vBattAvg, 100.0f, prev[RF_VBATT_AVG]);
+    rec.v[RF_VBATT_MIN] = relayFixed(heard ? ru.vBattMin : NAN, 100.0f, prev[RF_VBATT_MIN]);
+    rec.v[RF_TEMP_MAX] = relayFixed(heard ? ru.tempMax : NAN, 10.0f, prev[RF_TEMP_MAX]);
+    rec.v[RF_V5V_MIN] = relayFixed(heard ? ru.v5vMin : NAN, 100.0f, prev[RF_V5V_MIN]);
+    unsigned long gap = now - ru.lastPacketMillis;  // includes the current silence
+    if (ru.maxGapMs > gap) gap = ru.maxGapMs;
+    rec.v[RF_PACKETS] = ru.packets;
+    rec.v[RF_MAX_GAP] = (int32_t)(gap / 100);
+
+    const LapStats &ls = lapStats[id];
+    rec.v[RF_LAPS] = (int32_t)ls.totalLaps;
+    rec.v[RF_LAP_MEDIAN] = (int32_t)(lapMedian(ls) / 100);
+    rec.v[RF_LAP_P90] = (int32_t)(lapPercentile(ls, 90) / 100);
+    rec.v[RF_LAP_BEST] = ls.count > 0 ? (int32_t)(ls.sorted[0] / 100) : 0;
+
+    const ChargeSession *cs = chargeLastSession(id);
+    rec.v[RF_CHARGE_WH] = cs != NULL ? (int32_t)lroundf(cs->wh * 100.0f) : 0;
+    rec.v[RF_ALERTS] = alertStates[id].activeMask;
+
+    ru.packets = 0;
+    ru.maxGapMs = 0;
+    ru.vBattSamples = 0;
+    ru.vBattSum = 0.0f;
+  }
+  portEXIT_CRITICAL(&telemetryMux);
+  if (n == 0) return;
+
+  bool keyframe = (relayIntervalCount++ % RELAY_KEYFRAME_EVERY) == 0;
+  int done = 0;
+  while (done < n) {
+    uint8_t frame[RELAY_FRAME_MAX];
+    int used = 0;
+    size_t len = relayEncodeFrame(relayEncoder, &recs[done], min(n - done, RELAY_BATCH_MAX), keyframe,
+                                  (uint32_t)now, frame, &used);
+    relayTransmit(frame, len);
+    if (used == 0) break;
+    done += used;
+  }
 }
 
 void drawVBattGraph() {
@@ -358,6 +1057,99 @@ void drawVBattGraph() {
       lcd.drawLine(x1, y1, x2, y2, ST77XX_BLUE);
     }
   }
+
+  // Text overlays drawn on top of the graph
+  drawAlertBanner();
+  drawChargeStats();
+  drawLapStats();
+}
+
+// Red banner at the top of the graph area listing the active alerts
+void drawAlertBanner() {
+  if (desiredVehicleID < 0 || desiredVehicleID >= MAX_VEHICLES) return;
+
+  portENTER_CRITICAL(&telemetryMux);
+  uint16_t active = alertStates[desiredVehicleID].activeMask;
+  portEXIT_CRITICAL(&telemetryMux);
+  if (active == 0) return;
+
+  int total = 0;
+  for (int r = 0; r < ALERT_RULE_COUNT; r++) {
+    if (active & (1 << r)) total++;
+  }
+
+  // Whole names only; whatever doesn't fit is counted in a "+N" suffix
+  const size_t lineMax = 26;  // characters across the screen at text size 2
+  char line[lineMax + 1] = "";
+  int shown = 0;
+  for (int r = 0; r < ALERT_RULE_COUNT; r++) {
+    if (!(active & (1 << r))) continue;
+    size_t need = strlen(line) + (shown > 0 ? 1 : 0) + strlen(alertRules[r].name);
+    if (shown + 1 < total) need += 3;  // room for " +N" in case a later name doesn't fit
+    if (need > lineMax) break;
+    if (shown > 0) strcat(line, " ");
+    strcat(line, alertRules[r].name);
+    shown++;
+  }
+  if (shown < total) {
+    size_t used = strlen(line);
+    snprintf(line + used, sizeof(line) - used, "%s+%d", shown > 0 ? " " : "", total - shown);
+  }
+  int bannerY = 54;  // just below the pid marker
+  lcd.fillRect(4, bannerY, screenWidth - 8, 18, ST77XX_RED);
+  lcd.setCursor(6, bannerY + 2);
+  lcd.setTextSize(2);
+  lcd.setTextColor(ST77XX_WHITE);
+  lcd.print(line);
+}
+
+// Line above the lap stats: energy of the charge session in progress, or of the last one
+void drawChargeStats() {
+  if (desiredVehicleID < 0 || desiredVehicleID >= MAX_VEHICLES) return;
+
+  portENTER_CRITICAL(&telemetryMux);
+  bool active = chargeTrackers[desiredVehicleID].active;
+  ChargeSession cs = chargeTrackers[desiredVehicleID].session;
+  const ChargeSession *last = chargeLastSession(desiredVehicleID);
+  if (!active && last != NULL) cs = *last;
+  portEXIT_CRITICAL(&telemetryMux);
+  if (!active && last == NULL) return;
+
+  char durBuf[16];
+  formatDuration(cs.durationMs, durBuf, sizeof(durBuf));
+  char line[64];
+  snprintf(line, sizeof(line), "%s %.2fWh %.3fAh %s", active ? "Chg" : "Last chg", cs.wh, cs.ah, durBuf);
+  int lineY = screenHeight - 22;
+  lcd.fillRect(4, lineY, screenWidth - 8, 8, ST77XX_BLACK);
+  lcd.setCursor(4, lineY);
+  lcd.setTextSize(1);
+  lcd.setTextColor(active ? ST77XX_YELLOW : ST77XX_WHITE);
+  lcd.print(line);
+}
+
+// Bottom line of the graph area: last lap, rolling median, p90 and best lap
+void drawLapStats() {
+  if (desiredVehicleID < 0 || desiredVehicleID >= MAX_VEHICLES) return;
+
+  portENTER_CRITICAL(&telemetryMux);
+  LapStats ls = lapStats[desiredVehicleID];
+  portEXIT_CRITICAL(&telemetryMux);
+  if (ls.count == 0) return;
+
+  char lapBuf[16], medBuf[16], p90Buf[16], bestBuf[16];
+  formatLapTime(ls.lastLap, lapBuf, sizeof(lapBuf));
+  formatLapTime(lapMedian(ls), medBuf, sizeof(medBuf));
+  formatLapTime(lapPercentile(ls, 90), p90Buf, sizeof(p90Buf));
+  formatLapTime(ls.sorted[0], bestBuf, sizeof(bestBuf));
+
+  char line[80];
+  snprintf(line, sizeof(line), "Lap %s Med %s P90 %s Best %s", lapBuf, medBuf, p90Buf, bestBuf);
+  int lineY = screenHeight - 12;  // inside the 3px no-data border
+  lcd.fillRect(4, lineY, screenWidth - 8, 8, ST77XX_BLACK);
+  lcd.setCursor(4, lineY);
+  lcd.setTextSize(1);
+  lcd.setTextColor(ST77XX_CYAN);
+  lcd.print(line);
 }
 
 // Called from main loop to consume sharedData and update the display/graph
@@ -662,6 +1454,13 @@ void setup() {
   if (esp_now_init() == ESP_OK) {
     esp_now_register_recv_cb(receiveCallback);  // Register receive callback
     esp_now_register_send_cb(sentCallback);     // Register send callback
+    if (RELAY_MODE && RELAY_TRANSPORT == RELAY_TRANSPORT_ESPNOW && !esp_now_is_peer_exist(relayPeerMac)) {
+      esp_now_peer_info_t peer = {};
+      memcpy(peer.peer_addr, relayPeerMac, sizeof(relayPeerMac));
+      peer.channel = 0;   // current channel
+      peer.encrypt = false;
+      esp_now_add_peer(&peer);
+    }
   } else {
     delay(1000);
     ESP.restart();
@@ -725,6 +1524,15 @@ void loop() {
     // Update elapsed time display
     updateElapsedTimeDisplay();
 
+    // Close charge sessions for vehicles that went quiet while charging
+    chargeCloseStale();
+
+    // Relay mode: forward batched summaries on their own interval
+    if (RELAY_MODE && now - lastRelaySend >= RELAY_INTERVAL_MS) {
+      lastRelaySend = now;
+      relaySendSummaries();
+    }
+
     // If new data is available from ESP-NOW callback, update display
     if (newDataAvailable) {
       updateDisplayFromData();
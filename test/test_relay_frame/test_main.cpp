@@ -0,0 +1,175 @@
+#include <RelayFrame.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+// Frames pass through the file transport helpers, as a logger on a host would see them
+
+static const int FRAMES_MAX = 16;
+static uint8_t frames[FRAMES_MAX][RELAY_FRAME_MAX];
+static size_t frameLens[FRAMES_MAX];
+static int frameCount;
+
+static RelayCodecState enc;
+static RelayCodecState dec;
+
+static RelayRecord makeRecord(uint8_t id, int32_t seed) {
+  RelayRecord rec;
+  rec.vehicleID = id;
+  for (int f = 0; f < RF_COUNT; f++) rec.v[f] = seed * 10 + f + id * 1000;
+  return rec;
+}
+
+// Encode one interval the way relaySendSummaries does: batches of `batch` records per
+// frame, written to a temporary file and read back into frames[]
+static void sendInterval(const RelayRecord *recs, int n, bool keyframe, int batch) {
+  FILE *f = tmpfile();
+  TEST_ASSERT_NOT_NULL(f);
+  int done = 0;
+  while (done < n) {
+    uint8_t frame[RELAY_FRAME_MAX];
+    int used = 0;
+    int count = (n - done < batch) ? n - done : batch;
+    size_t len = relayEncodeFrame(enc, &recs[done], count, keyframe, 1000, frame, &used);
+    TEST_ASSERT_TRUE(len <= RELAY_FRAME_MAX);
+    TEST_ASSERT_TRUE(relayFileWriteFrame(f, frame, len));
+    TEST_ASSERT_TRUE(used > 0);
+    done += used;
+  }
+
+  rewind(f);
+  frameCount = 0;
+  long len;
+  while ((len = relayFileReadFrame(f, frames[frameCount], RELAY_FRAME_MAX)) >= 0) {
+    frameLens[frameCount++] = (size_t)len;
+    TEST_ASSERT_TRUE(frameCount < FRAMES_MAX);
+  }
+  fclose(f);
+}
+
+static int decode(int frame, RelayRecord *out) {
+  return relayDecodeFrame(dec, frames[frame], frameLens[frame], out, RELAY_MAX_VEHICLES, NULL);
+}
+
+static void assertRecordEqual(const RelayRecord &expected, const RelayRecord &actual) {
+  TEST_ASSERT_EQUAL_UINT8(expected.vehicleID, actual.vehicleID);
+  TEST_ASSERT_EQUAL_INT32_ARRAY(expected.v, actual.v, RF_COUNT);
+}
+
+void setUp(void) {
+  relayCodecReset(enc);
+  relayCodecReset(dec);
+}
+
+void tearDown(void) {}
+
+void test_keyframe_then_delta_roundtrip(void) {
+  RelayRecord recs[2] = {makeRecord(1, 5), makeRecord(4, 7)};
+  sendInterval(recs, 2, true, 4);
+  TEST_ASSERT_EQUAL_INT(1, frameCount);
+
+  RelayRecord out[RELAY_MAX_VEHICLES];
+  TEST_ASSERT_EQUAL_INT(2, decode(0, out));
+  assertRecordEqual(recs[0], out[0]);
+  assertRecordEqual(recs[1], out[1]);
+
+  // Only vehicle 4 changes, and only one field: vehicle 1 is left out of the frame
+  recs[1].v[RF_PACKETS] += 3;
+  sendInterval(recs, 2, false, 4);
+  TEST_ASSERT_TRUE(frameLens[0] < RELAY_HEADER_LEN + 8);
+  TEST_ASSERT_EQUAL_INT(1, decode(0, out));
+  assertRecordEqual(recs[1], out[0]);
+}
+
+void test_sequence_gap_drops_deltas_until_keyframe(void) {
+  RelayRecord recs[1] = {makeRecord(2, 1)};
+  RelayRecord out[RELAY_MAX_VEHICLES];
+  sendInterval(recs, 1, true, 4);
+  TEST_ASSERT_EQUAL_INT(1, decode(0, out));
+
+  recs[0].v[RF_VBATT_AVG] += 10;
+  sendInterval(recs, 1, false, 4);  // lost
+  recs[0].v[RF_VBATT_AVG] += 10;
+  sendInterval(recs, 1, false, 4);
+  TEST_ASSERT_EQUAL_INT(0, decode(0, out));
+
+  sendInterval(recs, 1, true, 4);
+  TEST_ASSERT_EQUAL_INT(1, decode(0, out));
+  assertRecordEqual(recs[0], out[0]);
+}
+
+void test_split_keyframe_with_missing_part(void) {
+  RelayRecord recs[RELAY_MAX_VEHICLES];
+  for (int id = 0; id < RELAY_MAX_VEHICLES; id++) recs[id] = makeRecord(id, id + 1);
+  sendInterval(recs, RELAY_MAX_VEHICLES, true, 3);
+  TEST_ASSERT_EQUAL_INT(3, frameCount);
+
+  // Frame 0 (vehicles 0..2) is lost; frames 1 and 2 arrive
+  RelayRecord out[RELAY_MAX_VEHICLES];
+  TEST_ASSERT_EQUAL_INT(3, decode(1, out));
+  TEST_ASSERT_EQUAL_INT(2, decode(2, out));
+
+  // Every vehicle changes; deltas for 0..2 must not be applied to unknown bases
+  for (int id = 0; id < RELAY_MAX_VEHICLES; id++) recs[id].v[RF_PACKETS] += 1;
+  sendInterval(recs, RELAY_MAX_VEHICLES, false, 3);
+  int seen = 0;
+  for (int i = 0; i < frameCount; i++) {
+    int n = decode(i, out);
+    TEST_ASSERT_TRUE(n >= 0);
+    for (int k = 0; k < n; k++) {
+      TEST_ASSERT_TRUE(out[k].vehicleID >= 3);
+      assertRecordEqual(recs[out[k].vehicleID], out[k]);
+      seen++;
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(5, seen);
+}
+
+void test_truncated_input_is_rejected(void) {
+  RelayRecord recs[3] = {makeRecord(0, 1), makeRecord(1, 2), makeRecord(2, 3)};
+  sendInterval(recs, 3, true, 4);
+
+  RelayRecord out[RELAY_MAX_VEHICLES];
+  for (size_t len = 0; len < frameLens[0]; len++) {
+    relayCodecReset(dec);
+    TEST_ASSERT_EQUAL_INT(-1, relayDecodeFrame(dec, frames[0], len, out, RELAY_MAX_VEHICLES, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, dec.syncedMask);
+  }
+
+  // A frame cut short in the file is not returned
+  FILE *f = tmpfile();
+  TEST_ASSERT_NOT_NULL(f);
+  TEST_ASSERT_TRUE(relayFileWriteFrame(f, frames[0], frameLens[0]));
+  fflush(f);
+  TEST_ASSERT_EQUAL_INT(0, ftruncate(fileno(f), (off_t)frameLens[0]));  // drop the last 2 bytes
+  rewind(f);
+  uint8_t buf[RELAY_FRAME_MAX];
+  TEST_ASSERT_EQUAL_INT32(-1, relayFileReadFrame(f, buf, sizeof(buf)));
+  fclose(f);
+}
+
+void test_extreme_values_roundtrip(void) {
+  RelayRecord recs[1] = {makeRecord(3, 0)};
+  for (int f = 0; f < RF_COUNT; f++) recs[0].v[f] = (f % 2) ? INT32_MAX : INT32_MIN;
+  RelayRecord out[RELAY_MAX_VEHICLES];
+  sendInterval(recs, 1, true, 4);
+  TEST_ASSERT_EQUAL_INT(1, decode(0, out));
+  assertRecordEqual(recs[0], out[0]);
+
+  // Deltas that overflow int32 must wrap back to the right values
+  for (int f = 0; f < RF_COUNT; f++) recs[0].v[f] = (f % 2) ? INT32_MIN : INT32_MAX;
+  sendInterval(recs, 1, false, 4);
+  TEST_ASSERT_EQUAL_INT(1, decode(0, out));
+  assertRecordEqual(recs[0], out[0]);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_keyframe_then_delta_roundtrip);
+  RUN_TEST(test_sequence_gap_drops_deltas_until_keyframe);
+  RUN_TEST(test_split_keyframe_with_missing_part);
+  RUN_TEST(test_truncated_input_is_rejected);
+  RUN_TEST(test_extreme_values_roundtrip);
+  return UNITY_END();
+}